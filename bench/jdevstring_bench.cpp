@@ -0,0 +1,103 @@
+// Throughput of the `std::string` vs `std::pmr` (per-request arena) overloads of jdevstring under
+// multi-threaded load. Each "request" splits a query-like string, base64url encodes & decodes every
+// token and builds a JWT, the arena is released once per request.
+//
+// usage: jdevtools_bench [requests per thread] [max threads]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "jdevtools/jdevstring.hpp"
+
+namespace {
+	// cheap stand-in for an hmac, so the benchmark measures string handling and allocation only
+	std::string fakeSignature(const std::string &secret, const std::string &msg) {
+		return std::to_string(std::hash<std::string>()(secret + msg));
+	}
+
+	std::string makeInput() {
+		std::string input;
+		for (int i = 0; i < 64; i++) {
+			if (i) input += '&';
+			input += "field" + std::to_string(i) + "=value-of-some-length-" + std::to_string(i * 7919);
+		}
+		return input;
+	}
+
+	size_t requestStd(const std::string &input, const std::string &secret) {
+		size_t sum = 0;
+		std::vector<std::string> tokens = jdevtools::split(input, "&");
+		for (const std::string &token : tokens) {
+			std::string encoded = jdevtools::base64urlEncode(token);
+			sum += jdevtools::base64urlDecode(encoded).size();
+		}
+		std::string jwt = jdevtools::createJWT(secret, tokens[0], tokens[1], fakeSignature);
+		return sum + jwt.size();
+	}
+
+	size_t requestPmr(const std::string &input, const std::string &secret, std::pmr::memory_resource *mr) {
+		size_t sum = 0;
+		std::pmr::vector<std::pmr::string> tokens = jdevtools::split(input, "&", mr);
+		for (const std::pmr::string &token : tokens) {
+			std::pmr::string encoded = jdevtools::base64urlEncode(token, mr);
+			sum += jdevtools::base64urlDecode(encoded, mr).size();
+		}
+		std::pmr::string jwt = jdevtools::createJWT(secret, tokens[0], tokens[1], fakeSignature, mr);
+		return sum + jwt.size();
+	}
+
+	// returns requests per second over all threads
+	template <class Work>
+	double run(unsigned threads, long requests, Work work) {
+		std::atomic<size_t> sink{0};
+		std::vector<std::thread> pool;
+		auto start = std::chrono::steady_clock::now();
+		for (unsigned t = 0; t < threads; t++) {
+			pool.emplace_back([&] { sink += work(requests); });
+		}
+		for (std::thread &th : pool) th.join();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		return threads * requests / elapsed.count();
+	}
+}
+
+int main(int argc, char **argv) {
+	long requests = argc > 1 ? std::atol(argv[1]) : 20000;
+	unsigned maxThreads = argc > 2 ? std::atoi(argv[2]) : std::thread::hardware_concurrency();
+	if (maxThreads == 0) maxThreads = 1;
+
+	const std::string input = makeInput();
+	const std::string secret = "secret";
+
+	std::vector<unsigned> threadCounts;
+	for (unsigned threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+	threadCounts.push_back(maxThreads);
+
+	std::printf("%8s %16s %16s %8s\n", "threads", "std req/s", "pmr req/s", "speedup");
+	for (unsigned threads : threadCounts) {
+		double stdRate = run(threads, requests, [&](long n) {
+			size_t sum = 0;
+			for (long i = 0; i < n; i++) sum += requestStd(input, secret);
+			return sum;
+		});
+		double pmrRate = run(threads, requests, [&](long n) {
+			size_t sum = 0;
+			// per-thread buffer, each request starts from an empty arena over it
+			std::vector<char> buffer(64 * 1024);
+			for (long i = 0; i < n; i++) {
+				std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+				sum += requestPmr(input, secret, &arena);
+			}
+			return sum;
+		});
+		std::printf("%8u %16.0f %16.0f %7.2fx\n", threads, stdRate, pmrRate, pmrRate / stdRate);
+	}
+	return 0;
+}
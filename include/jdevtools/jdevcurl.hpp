@@ -1,10 +1,23 @@
 #ifndef JDEVTOOLS_JDEVCURL_HPP
 #define JDEVTOOLS_JDEVCURL_HPP
 
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory_resource>
+#include <random>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "jdevtools/jdevstring.hpp"
+
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#endif
+
 namespace {
 #if defined(_WIN32)
 #define popen _popen
@@ -27,6 +40,105 @@ namespace {
 		pclose(pipe);
 		return result;
 	}
+
+	// same as above, but output is accumulated in a string allocated from `mr`
+	inline std::pmr::string exec(const char *cmd, std::pmr::memory_resource *mr) {
+		char buffer[4096];
+		std::pmr::string result(mr);
+		FILE *pipe = popen(cmd, "r");
+		if (!pipe) throw std::runtime_error("popen() failed!");
+		try {
+			size_t n;
+			while ((n = fread(buffer, 1, sizeof buffer, pipe)) > 0) {
+				result.append(buffer, n);
+			}
+		} catch (...) {
+			pclose(pipe);
+			throw;
+		}
+		pclose(pipe);
+		return result;
+	}
+
+	// runs `cmd`, appends its stdout to `output` and returns its exit status (-1 if it did not exit normally)
+	inline int execStatus(const char *cmd, std::string &output) {
+		char buffer[4096];
+		FILE *pipe = popen(cmd, "r");
+		if (!pipe) throw std::runtime_error("popen() failed!");
+		try {
+			size_t n;
+			while ((n = fread(buffer, 1, sizeof buffer, pipe)) > 0) {
+				output.append(buffer, n);
+			}
+		} catch (...) {
+			pclose(pipe);
+			throw;
+		}
+		int status = pclose(pipe);
+	#if defined(_WIN32)
+		return status;
+	#else
+		return status != -1 && WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+	#endif
+	}
+
+	// quotes `value` for a curl config file (`-K`): wraps in `"` and escapes `\`, `"` and line breaks
+	inline std::string configQuote(std::string_view value) {
+		std::string quoted = "\"";
+		quoted.reserve(value.size() + 2);
+		for (char c : value) {
+			switch (c) {
+				case '\\': quoted += "\\\\"; break;
+				case '"': quoted += "\\\""; break;
+				case '\n': quoted += "\\n"; break;
+				case '\r': quoted += "\\r"; break;
+				case '\t': quoted += "\\t"; break;
+				default: quoted += c;
+			}
+		}
+		quoted += '"';
+		return quoted;
+	}
+
+	// creates a fresh, uniquely named directory under the system temp path, accessible by the owner only
+	// (it holds request headers, bodies and responses)
+	inline std::filesystem::path makeTempDir(const char *prefix) {
+		std::filesystem::path base = std::filesystem::temp_directory_path();
+	#if !defined(_WIN32)
+		// mkdtemp creates it with mode 0700 atomically
+		std::string dir = (base / prefix).string() + "XXXXXX";
+		if (mkdtemp(&dir[0])) return dir;
+	#else
+		static thread_local std::mt19937_64 gen(std::random_device{}());
+		for (int attempt = 0; attempt < 16; attempt++) {
+			std::ostringstream name;
+			name << prefix << std::hex << gen();
+			std::filesystem::path dir = base / name.str();
+			if (std::filesystem::create_directory(dir)) {
+				std::filesystem::permissions(dir, std::filesystem::perms::owner_all, std::filesystem::perm_options::replace);
+				return dir;
+			}
+		}
+	#endif
+		throw std::runtime_error("could not create temp directory!");
+	}
+
+	// removes `path` (if set) with everything in it on scope exit
+	struct tempDirGuard {
+		std::filesystem::path path;
+		~tempDirGuard() {
+			std::error_code ec;
+			if (!path.empty()) std::filesystem::remove_all(path, ec);
+		}
+	};
+
+	inline std::string readFile(const std::filesystem::path &path) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file) return "";
+		std::ostringstream content;
+		content << file.rdbuf();
+		return content.str();
+	}
 }
 
 namespace jdevtools {
@@ -39,33 +151,193 @@ namespace jdevtools {
 		std::vector<std::string> urlEncodeDatas;
 	};
 
+	struct batchOptions {
+		// every transfer is sent as `-X POST` instead of `--location`
+		bool isPost = false;
+		// max transfers curl runs at once (`--parallel-max`, curl caps it at 300)
+		int parallelMax = 50;
+	};
+
+	struct responseData {
+		std::string body;
+		// `%{http_code}` of the transfer, 0 if no response was received
+		long httpCode = 0;
+		// curl exit code of the transfer (`%{exitcode}`), 0 on success, -1 if curl never reported it
+		int curlCode = -1;
+	};
+
+	// bodies longer than this are handed to curl through a temp file instead of the command line
+	inline const size_t INLINE_BODY_MAX = 4096;
+
+	// encodes `postData` and `urlEncodeDatas` into what curl would send for them, in input order, following
+	// `--data-urlencode` rules (`content`, `=content`, `name=content`, spaces as '+'); `postData` is taken as is.
+	// consecutive inline fields are joined by a `QueryBuilder<Str>` (allocated with `alloc`) and passed to
+	// `emit(body, false)`, `@file` & `name@file` entries need curl to read the file and are passed to `emit(entry, true)`.
+	// curl joins the emitted pieces with '&', same as separate `-d` arguments; empty fields are kept,
+	// so `{""}` still makes a (empty) POST and `{"", "a=1"}` still sends `&a=1`
+	template <class Str = std::string, class Emit>
+	inline void encodeRequestBody(const requestData &req, Emit emit,
+	const typename Str::allocator_type &alloc = typename Str::allocator_type()) {
+		size_t total = req.postData.size();
+		for (const std::string &data : req.urlEncodeDatas) total += data.size() + 1;
+		QueryBuilder<Str> body(alloc, total + total / 2);
+		if (req.postData.size()) body.addRaw(req.postData);
+
+		for (const std::string &data : req.urlEncodeDatas) {
+			size_t eq = data.find('='), at = data.find('@');
+			if (at < eq) {
+				if (body.fields()) emit(std::string_view(body.str()), false);
+				body.clear();
+				emit(std::string_view(data), true);
+				continue;
+			}
+			if (eq == std::string::npos) body.add(data);
+			else if (eq == 0) body.add(std::string_view(data).substr(1));
+			else body.addRawName(std::string_view(data).substr(0, eq), std::string_view(data).substr(eq + 1));
+		}
+
+		if (body.fields()) emit(std::string_view(body.str()), false);
+	}
+}
+
+namespace {
+	// appends the request body to `command`: inline data as ` --data-raw "data"`, or ` --data-binary "@file"`
+	// (file owned by `spill`) when longer than `INLINE_BODY_MAX`, both send it literally.
+	// `@file` entries go as ` --data-urlencode "entry"` at their position
+	template <class Str>
+	inline void appendBody(Str &command, const jdevtools::requestData &req, tempDirGuard &spill) {
+		size_t spilled = 0;
+		jdevtools::encodeRequestBody<Str>(req, [&](std::string_view piece, bool isFile) {
+			if (isFile) {
+				command.append(" --data-urlencode \"").append(piece) += '"';
+			} else if (piece.size() <= jdevtools::INLINE_BODY_MAX) {
+				command.append(" --data-raw \"").append(piece) += '"';
+			} else {
+				if (spill.path.empty()) spill.path = makeTempDir("jdevcurl-");
+				std::filesystem::path file = spill.path / ("body" + std::to_string(spilled++));
+				std::ofstream out(file, std::ios::binary);
+				out.write(piece.data(), piece.size());
+				out.close();
+				if (!out) throw std::runtime_error("could not write request body!");
+				command.append(" --data-binary \"@").append(file.string()) += '"';
+			}
+		}, command.get_allocator());
+	}
+}
+
+namespace jdevtools {
+
 	// runs commad with following startings:
 	// always `curl -s -o - `
 	// + if post `-X POST "url"`
 	// + if nopost `--location "url"`
 	// + for each header ` -H "header"`
-	// + for each data to be url encoded ` --data-urlencode "urlEncodeData"`
-	// + for post data ` -d "postData"`
+	// + for post data & data to be url encoded (encoded here, see `encodeRequestBody`) ` --data-raw "body"`,
+	// or ` --data-binary "@tempfile"` if body is longer than `INLINE_BODY_MAX` (post data is always sent literally)
+	// + for each data to be url encoded from file (`@file`) ` --data-urlencode "urlEncodeData"`, in input order
 	inline std::string sender(const requestData &req, bool isPost = false) {
 		std::string command = "curl -s -o - ";
 		if (isPost) command += "-X POST \"" + req.url + '"';
 		else command += "--location \"" + req.url + '"';
-		for (int i = 0; i < req.headers.size(); i++) {
+		for (size_t i = 0; i < req.headers.size(); i++) {
 			command += " -H \"" + req.headers[i] + '"';
 		}
-		if (req.postData.size()) command += " -d \"" + req.postData + '"';
-		for (int i = 0; i < req.urlEncodeDatas.size(); i++) {
-			command += " --data-urlencode \"" + req.urlEncodeDatas[i] + '"';
-		}
+		tempDirGuard spill;
+		appendBody(command, req, spill);
 		return exec(command.data());
 	}
 
+	// same as above, but the command, the encoded body and the response are allocated from `mr`
+	// (only the temp file path of a body longer than `INLINE_BODY_MAX` uses the global heap)
+	inline std::pmr::string sender(const requestData &req, bool isPost, std::pmr::memory_resource *mr) {
+		std::pmr::string command("curl -s -o - ", mr);
+		if (isPost) command.append("-X POST \"").append(req.url) += '"';
+		else command.append("--location \"").append(req.url) += '"';
+		for (size_t i = 0; i < req.headers.size(); i++) {
+			command.append(" -H \"").append(req.headers[i]) += '"';
+		}
+		tempDirGuard spill;
+		appendBody(command, req, spill);
+		return exec(command.data(), mr);
+	}
+
 	// runs commad with following starting:
 	//`curl -s -o - `
 	inline std::string sender(const char *cmd) {
 		std::string command = "curl -s -o - " + std::string(cmd);
 		return exec(command.data());
 	}
+
+	// same as above, but the command and the response are allocated from `mr`
+	inline std::pmr::string sender(const char *cmd, std::pmr::memory_resource *mr) {
+		std::pmr::string command("curl -s -o - ", mr);
+		command += cmd;
+		return exec(command.data(), mr);
+	}
+
+	// sends all `reqs` with a single curl process: transfers are written to a config file (`-K`),
+	// separated by `next` and run with `parallel`, so process startup is paid once and connections are reused.
+	// each transfer has its own output file and reports `index http_code exitcode` on stdout (`write-out`),
+	// results are returned in input order. Throws if curl fails as a whole or any transfer is left unreported
+	// (bad config, curl older than 7.75)
+	inline std::vector<responseData> sendBatch(const std::vector<requestData> &reqs,
+	const batchOptions &options = batchOptions()) {
+		std::vector<responseData> results(reqs.size());
+		if (reqs.empty()) return results;
+
+		tempDirGuard dir{makeTempDir("jdevcurl-")};
+		std::filesystem::path config = dir.path / "batch.cfg";
+		{
+			std::ofstream cfg(config, std::ios::binary);
+			int parallelMax = options.parallelMax < 1 ? 1 : options.parallelMax > 300 ? 300 : options.parallelMax;
+			cfg << "no-progress-meter\nparallel\nparallel-max = " << parallelMax << '\n';
+			for (size_t i = 0; i < reqs.size(); i++) {
+				const requestData &req = reqs[i];
+				if (i) cfg << "next\n";
+				cfg << "url = " << configQuote(req.url) << '\n';
+				cfg << "output = " << configQuote((dir.path / std::to_string(i)).string()) << '\n';
+				cfg << "write-out = " << configQuote(std::to_string(i) + " %{http_code} %{exitcode}\n") << '\n';
+				if (options.isPost) cfg << "request = \"POST\"\n";
+				else cfg << "location\n";
+				for (size_t j = 0; j < req.headers.size(); j++) {
+					cfg << "header = " << configQuote(req.headers[j]) << '\n';
+				}
+				encodeRequestBody(req, [&cfg](std::string_view piece, bool isFile) {
+					cfg << (isFile ? "data-urlencode = " : "data-raw = ") << configQuote(piece) << '\n';
+				});
+			}
+			if (!cfg) throw std::runtime_error("could not write curl config!");
+		}
+
+		std::string command = "curl -s -K \"" + config.string() + '"';
+		std::string report;
+		int status = execStatus(command.data(), report);
+
+		// every line must be exactly `index http_code exitcode`, an unknown `%{exitcode}` (curl < 7.75) leaves it empty
+		std::istringstream lines(report);
+		std::string line;
+		while (std::getline(lines, line)) {
+			if (line.empty()) continue;
+			std::istringstream fields(line);
+			size_t index;
+			long httpCode;
+			int curlCode;
+			if (!(fields >> index >> httpCode >> curlCode) || !(fields >> std::ws).eof() || index >= results.size()) {
+				throw std::runtime_error("unexpected curl report line: " + line);
+			}
+			results[index].httpCode = httpCode;
+			results[index].curlCode = curlCode;
+		}
+
+		for (size_t i = 0; i < reqs.size(); i++) {
+			if (results[i].curlCode == -1) {
+				throw std::runtime_error("curl did not report transfer " + std::to_string(i) +
+					" (exit code " + std::to_string(status) + ")!");
+			}
+			results[i].body = readFile(dir.path / std::to_string(i));
+		}
+		return results;
+	}
 }
 
 #endif
\ No newline at end of file
@@ -1,10 +1,22 @@
 #ifndef JDEVTOOLS_JDEVSTRING_HPP
 #define JDEVTOOLS_JDEVSTRING_HPP
 
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstring>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
+// define `JDEVTOOLS_NO_SIMD` to force the portable code paths
+#if !defined(JDEVTOOLS_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define JDEVTOOLS_URL_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace jdevtools {
 	typedef unsigned char BYTE;
 	inline const char BASE64_URL_ALPHABET[] =
@@ -12,6 +24,17 @@ namespace jdevtools {
 		"abcdefghijklmnopqrstuvwxyz"
 		"0123456789-_"
 	;
+	inline const char URL_HEX_DIGITS[] = "0123456789ABCDEF";
+
+	// RFC 3986 unreserved characters (`A-Z a-z 0-9 - . _ ~`), everything else gets percent-encoded
+	inline constexpr std::array<bool, 256> URL_UNRESERVED = [] {
+		std::array<bool, 256> table{};
+		for (int c = 'A'; c <= 'Z'; c++) table[c] = true;
+		for (int c = 'a'; c <= 'z'; c++) table[c] = true;
+		for (int c = '0'; c <= '9'; c++) table[c] = true;
+		table['-'] = table['.'] = table['_'] = table['~'] = true;
+		return table;
+	}();
 
 	inline std::string strTokenize(const std::string &str, const char *delim, size_t &prev);
 	inline std::vector<std::string> split(const std::string &str, const char *delimiter);
@@ -20,6 +43,22 @@ namespace jdevtools {
 	inline std::string base64urlEncode(const std::string &input);
 	inline std::string base64urlDecode(const std::string &input);
 
+	// `std::pmr` overloads: every returned string/vector (and all of its temporaries) is allocated from `mr`,
+	// so a caller can pass a per-request `std::pmr::monotonic_buffer_resource` and release everything at once
+	inline std::pmr::vector<std::pmr::string> split(std::string_view str, const char *delimiter,
+	std::pmr::memory_resource *mr);
+	inline std::pmr::string base64urlEncode(const std::vector<BYTE> &data, std::pmr::memory_resource *mr);
+	inline std::pmr::string base64urlEncode(std::string_view input, std::pmr::memory_resource *mr);
+	inline std::pmr::string base64urlDecode(std::string_view input, std::pmr::memory_resource *mr);
+
+	// percent-encodes `input` (upper case hex) and appends it to `out`, resizing `out` exactly once.
+	// `spaceAsPlus` writes ' ' as '+' (application/x-www-form-urlencoded, same as curl `--data-urlencode`)
+	inline void urlEncode(std::string_view input, std::string &out, bool spaceAsPlus = false);
+	inline void urlEncode(std::string_view input, std::pmr::string &out, bool spaceAsPlus = false);
+	inline std::string urlEncode(std::string_view input, bool spaceAsPlus = false);
+	// decodes `%XY` sequences, malformed ones are copied as is. `plusAsSpace` turns '+' into ' '
+	inline std::string urlDecode(std::string_view input, bool plusAsSpace = false);
+
 	// `hmac_sha` can be any hashing function that takes 2 str `secret` & `msg` and returns str `signature`
 	inline std::string createJWT(const char *secret, const char *payload,
 	const char *header, std::string (&hmac_sha)(const char *, const char *));
@@ -28,6 +67,11 @@ namespace jdevtools {
 	inline std::string createJWT(const std::string &secret, const std::string &payload,
 	const std::string &header, std::string (&hmac_sha2)(const std::string &, const std::string &));
 
+	// same as above, but the token is built in a single buffer allocated from `mr`.
+	// `hmac_sha2` takes & returns `std::string`, so the message passed to it and the signature use the global heap
+	inline std::pmr::string createJWT(const std::string &secret, std::string_view payload, std::string_view header,
+	std::string (&hmac_sha2)(const std::string &, const std::string &), std::pmr::memory_resource *mr);
+
 
 	std::string strTokenize(const std::string &str, const char *delim, size_t &prev) {
 		size_t pos = str.find(delim, prev), temp = prev;
@@ -36,77 +80,292 @@ namespace jdevtools {
 		return str.substr(temp, pos - temp);
 	}
 
-	std::vector<std::string> split(const std::string &str, const char *delim) {
-		std::vector<std::string> tokens;
-		size_t prev = 0, pos;
+	namespace {
+		// bit i set when `p[i]` is unreserved
+		inline int urlUnreservedMask16(const char *p) {
+		#ifdef JDEVTOOLS_URL_SSE2
+			// signed compares: bytes >= 0x80 are negative, so they fall outside every range
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+			auto inRange = [&v](char lo, char hi) {
+				return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+			};
+			__m128i ok = _mm_or_si128(_mm_or_si128(inRange('a', 'z'), inRange('A', 'Z')), inRange('0', '9'));
+			ok = _mm_or_si128(ok, _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('-')), _mm_cmpeq_epi8(v, _mm_set1_epi8('.'))));
+			ok = _mm_or_si128(ok, _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('_')), _mm_cmpeq_epi8(v, _mm_set1_epi8('~'))));
+			return _mm_movemask_epi8(ok);
+		#else
+			int mask = 0;
+			for (int i = 0; i < 16; i++) mask |= URL_UNRESERVED[(BYTE)p[i]] << i;
+			return mask;
+		#endif
+		}
+
+		inline int hexValue(char c) {
+			if (c >= '0' && c <= '9') return c - '0';
+			if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+			if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+			return -1;
+		}
+
+		// shared bodies of the `std::string` & `std::pmr` overloads below, `Vec`/`Str` is the output type
+		template <class Vec>
+		inline void splitInto(std::string_view str, const char *delim, Vec &tokens) {
+			size_t prev = 0, pos, delimLen = strlen(delim);
+
+			while (prev < str.length()) {
+				pos = str.find(delim, prev);
+				if (pos == std::string_view::npos) pos = str.length();
+				tokens.emplace_back(str.substr(prev, pos - prev));
+				prev = pos + delimLen;
+			}
+		}
+
+		// `lastBits` encodes the trailing partial sextet (the `std::vector<BYTE>` overloads have always dropped it)
+		template <class Str>
+		inline void base64urlEncodeInto(const BYTE *data, size_t len, Str &encoded, bool lastBits) {
+			encoded.reserve(encoded.size() + (len * 4 + 2) / 3);
+			int val = 0, valb = -6;
+
+			for (size_t i = 0; i < len; i++) {
+				val = (val << 8) | data[i];
+				valb += 8;
+				while (valb >= 0) {
+					encoded.push_back(BASE64_URL_ALPHABET[(val >> valb) & 0x3F]);
+					valb -= 6;
+				}
+			}
+
+			if (lastBits && valb > -6) {
+				encoded.push_back(BASE64_URL_ALPHABET[((val << 8) >> (valb + 8)) & 0x3F]);
+			}
+			// No padding per RFC 4648
+		}
+
+		template <class Str>
+		inline void base64urlDecodeInto(std::string_view input, Str &decoded) {
+			int T[256];
+			std::fill(T, T + 256, -1);
+
+			for (size_t i = 0; i < std::strlen(BASE64_URL_ALPHABET); i++) {
+				T[(BYTE)BASE64_URL_ALPHABET[i]] = i;
+			}
+
+			decoded.reserve(decoded.size() + input.size() * 3 / 4);
+			int val = 0, valb = -8;
 
-		while (prev < str.length()) {
-			pos = str.find(delim, prev);
-			if (pos == std::string::npos) pos = str.length();
-			tokens.push_back(str.substr(prev, pos - prev));
-			prev = pos + strlen(delim);
+			for (BYTE c : input) {
+				if (T[c] == -1) break; // Ignore invalid characters
+				val = (val << 6) | T[c];
+				valb += 6;
+				if (valb >= 0) {
+					decoded.push_back(char((val >> valb) & 0xFF));
+					valb -= 8;
+				}
+			}
 		}
 
+		template <class Str>
+		inline void urlEncodeInto(std::string_view input, Str &out, bool spaceAsPlus) {
+			const char *src = input.data();
+			const size_t len = input.size();
+
+			// first pass: count bytes that expand to `%XY`, so `out` is grown exactly once
+			size_t escaped = 0, i = 0;
+			for (; i + 16 <= len; i += 16) escaped += 16 - std::bitset<16>(urlUnreservedMask16(src + i)).count();
+			for (; i < len; i++) escaped += !URL_UNRESERVED[(BYTE)src[i]];
+			if (spaceAsPlus) escaped -= std::count(input.begin(), input.end(), ' ');
+
+			size_t start = out.size();
+			out.resize(start + len + escaped * 2);
+			char *dst = &out[start];
+
+			auto encodeByte = [&dst, spaceAsPlus](BYTE c) {
+				if (URL_UNRESERVED[c]) *dst++ = c;
+				else if (c == ' ' && spaceAsPlus) *dst++ = '+';
+				else {
+					*dst++ = '%';
+					*dst++ = URL_HEX_DIGITS[c >> 4];
+					*dst++ = URL_HEX_DIGITS[c & 0x0F];
+				}
+			};
+
+			// second pass: fully unreserved 16 byte blocks are copied as is
+			for (i = 0; i + 16 <= len; i += 16) {
+				if (urlUnreservedMask16(src + i) == 0xFFFF) {
+					memcpy(dst, src + i, 16);
+					dst += 16;
+				} else {
+					for (size_t j = i; j < i + 16; j++) encodeByte(src[j]);
+				}
+			}
+			for (; i < len; i++) encodeByte(src[i]);
+		}
+	}
+
+	std::vector<std::string> split(const std::string &str, const char *delim) {
+		std::vector<std::string> tokens;
+		splitInto(str, delim, tokens);
 		return tokens;
 	}
 
 	std::string base64urlEncode(const std::vector<BYTE> &data) {
 		std::string encoded;
-		int val = 0, valb = -6;
-		for (BYTE c : data) {
-			val = (val << 8) + c;
-			valb += 8;
-			while (valb >= 0) {
-				encoded.push_back(BASE64_URL_ALPHABET[(val >> valb) & 0x3F]);
-				valb -= 6;
-			}
-		}
+		base64urlEncodeInto(data.data(), data.size(), encoded, false);
 		return encoded;
 	}
 
 	std::string base64urlEncode(const std::string &input) {
 		std::string encoded;
-		int val = 0, valb = -6;
-
-		for (BYTE c : input) {
-			val = (val << 8) | c;
-			valb += 8;
-			while (valb >= 0) {
-				encoded.push_back(BASE64_URL_ALPHABET[(val >> valb) & 0x3F]);
-				valb -= 6;
-			}
-		}
+		base64urlEncodeInto(reinterpret_cast<const BYTE *>(input.data()), input.size(), encoded, true);
+		return encoded;
+	}
 
-		if (valb > -6) {
-			encoded.push_back(BASE64_URL_ALPHABET[((val << 8) >> (valb + 8)) & 0x3F]);
-		}
+	std::string base64urlDecode(const std::string &input) {
+		std::string decoded;
+		base64urlDecodeInto(input, decoded);
+		return decoded;
+	}
 
-		return encoded; // No padding per RFC 4648
+	std::pmr::vector<std::pmr::string> split(std::string_view str, const char *delim, std::pmr::memory_resource *mr) {
+		std::pmr::vector<std::pmr::string> tokens(mr);
+		splitInto(str, delim, tokens);
+		return tokens;
 	}
 
-	std::string base64urlDecode(const std::string &input) {
-		std::vector<int> T(256, -1);
+	std::pmr::string base64urlEncode(const std::vector<BYTE> &data, std::pmr::memory_resource *mr) {
+		std::pmr::string encoded(mr);
+		base64urlEncodeInto(data.data(), data.size(), encoded, false);
+		return encoded;
+	}
 
-		for (size_t i = 0; i < std::strlen(BASE64_URL_ALPHABET); i++) {
-			T[BASE64_URL_ALPHABET[i]] = i;
-		}
+	std::pmr::string base64urlEncode(std::string_view input, std::pmr::memory_resource *mr) {
+		std::pmr::string encoded(mr);
+		base64urlEncodeInto(reinterpret_cast<const BYTE *>(input.data()), input.size(), encoded, true);
+		return encoded;
+	}
+
+	std::pmr::string base64urlDecode(std::string_view input, std::pmr::memory_resource *mr) {
+		std::pmr::string decoded(mr);
+		base64urlDecodeInto(input, decoded);
+		return decoded;
+	}
+
+	void urlEncode(std::string_view input, std::string &out, bool spaceAsPlus) {
+		urlEncodeInto(input, out, spaceAsPlus);
+	}
 
+	void urlEncode(std::string_view input, std::pmr::string &out, bool spaceAsPlus) {
+		urlEncodeInto(input, out, spaceAsPlus);
+	}
+
+	std::string urlEncode(std::string_view input, bool spaceAsPlus) {
+		std::string encoded;
+		urlEncode(input, encoded, spaceAsPlus);
+		return encoded;
+	}
+
+	std::string urlDecode(std::string_view input, bool plusAsSpace) {
 		std::string decoded;
-		int val = 0, valb = -8;
-
-		for (BYTE c : input) {
-			if (T[c] == -1) break; // Ignore invalid characters
-			val = (val << 6) | T[c];
-			valb += 6;
-			if (valb >= 0) {
-				decoded.push_back(char((val >> valb) & 0xFF));
-				valb -= 8;
+		decoded.reserve(input.size());
+		size_t i = 0;
+
+		while (i < input.size()) {
+			// copy the run up to the next special character in bulk
+			size_t next = plusAsSpace ? input.find_first_of("%+", i) : input.find('%', i);
+			if (next == std::string_view::npos) next = input.size();
+			decoded.append(input.data() + i, next - i);
+			if (next == input.size()) break;
+
+			i = next + 1;
+			if (input[next] == '+') {
+				decoded.push_back(' ');
+				continue;
 			}
+			int hi = i + 1 < input.size() ? hexValue(input[i]) : -1;
+			int lo = hi >= 0 ? hexValue(input[i + 1]) : -1;
+			if (lo < 0) {
+				decoded.push_back('%');
+				continue;
+			}
+			decoded.push_back(char((hi << 4) | lo));
+			i += 2;
 		}
 
 		return decoded;
 	}
 
+	// builds `name=value&name=value...` (query string or form body) in one growing buffer of type `Str`
+	// (e.g. `QueryBuilder<std::pmr::string> query(mr)`). names and values are percent-encoded, spaces as '+'
+	// unless `spaceAsPlus` is false. every `add*` call is one field, empty ones included (`""`, `"a"` -> `&a`)
+	template <class Str = std::string>
+	class QueryBuilder {
+	public:
+		explicit QueryBuilder(size_t reserve = 0, bool spaceAsPlus = true) : m_spaceAsPlus(spaceAsPlus) {
+			m_buffer.reserve(reserve);
+		}
+
+		explicit QueryBuilder(const typename Str::allocator_type &alloc, size_t reserve = 0, bool spaceAsPlus = true)
+		: m_buffer(alloc), m_spaceAsPlus(spaceAsPlus) {
+			m_buffer.reserve(reserve);
+		}
+
+		QueryBuilder &add(std::string_view name, std::string_view value) {
+			separate();
+			urlEncodeInto(name, m_buffer, m_spaceAsPlus);
+			m_buffer.push_back('=');
+			urlEncodeInto(value, m_buffer, m_spaceAsPlus);
+			return *this;
+		}
+
+		// appends a single encoded value without a name
+		QueryBuilder &add(std::string_view value) {
+			separate();
+			urlEncodeInto(value, m_buffer, m_spaceAsPlus);
+			return *this;
+		}
+
+		// appends `name` as is (already encoded) and the encoded `value`
+		QueryBuilder &addRawName(std::string_view name, std::string_view value) {
+			separate();
+			m_buffer.append(name);
+			m_buffer.push_back('=');
+			urlEncodeInto(value, m_buffer, m_spaceAsPlus);
+			return *this;
+		}
+
+		// appends already encoded data as is
+		QueryBuilder &addRaw(std::string_view encoded) {
+			separate();
+			m_buffer.append(encoded);
+			return *this;
+		}
+
+		void reserve(size_t size) { m_buffer.reserve(size); }
+		void clear() {
+			m_buffer.clear();
+			m_fields = 0;
+		}
+		bool empty() const { return m_fields == 0; }
+		// number of fields added since construction / `clear`
+		size_t fields() const { return m_fields; }
+		size_t size() const { return m_buffer.size(); }
+		const Str &str() const { return m_buffer; }
+		Str release() {
+			Str out = std::move(m_buffer);
+			clear();
+			return out;
+		}
+
+	private:
+		void separate() {
+			if (m_fields++) m_buffer.push_back('&');
+		}
+
+		Str m_buffer;
+		size_t m_fields = 0;
+		bool m_spaceAsPlus;
+	};
+
 	std::string createJWT(const char *secret, const char *payload, const char *header,
 	std::string (&hmac_sha)(const char *, const char *)) {
 		std::string encodedHeader = base64urlEncode(header);
@@ -125,6 +384,21 @@ namespace jdevtools {
 		return message + "." + encodedSignature;
 	}
 
+	std::pmr::string createJWT(const std::string &secret, std::string_view payload, std::string_view header,
+	std::string (&signature_encode)(const std::string &, const std::string &), std::pmr::memory_resource *mr) {
+		std::pmr::string token = base64urlEncode(header, mr);
+		std::pmr::string encodedPayload = base64urlEncode(payload, mr);
+		// header + '.' + payload + '.' + signature (hex of sha512 is the longest we ship: 128 chars)
+		token.reserve(token.size() + encodedPayload.size() + 2 + 128);
+		token += '.';
+		token += encodedPayload;
+		// hmac signature functions take std::string, so the message is copied once for them
+		std::string encodedSignature = signature_encode(secret, std::string(token));
+		token += '.';
+		token += encodedSignature;
+		return token;
+	}
+
 	#ifdef JDEVTOOLS_SHA256HMAC_HPP
 	#include "jdevtools/sha256hmac.hpp"
 	// default jwt with `"alg":"HS256","typ":"JWT"` header
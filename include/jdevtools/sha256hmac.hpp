@@ -76,6 +76,51 @@ namespace jdevtools {
 			return std::vector<unsigned char>(digest, digest + DigestSize);
 		}
 	
+		// Copy of the current state, e.g. to hash many messages sharing a common prefix.
+		SHA256 clone() const { return *this; }
+	
+		// Serialize the intermediate state so hashing can be resumed later (or in another process) with `importState`.
+		// Layout (big-endian): tag 0x01, state, bit length, buffered byte count, buffered bytes (42 + 0..BlockSize - 1 bytes).
+		std::vector<unsigned char> exportState() const {
+			std::vector<unsigned char> blob;
+			blob.reserve(StateHeaderSize + m_datalen);
+			blob.push_back(StateTag);
+			for (int i = 0; i < 8; i++)
+				for (int j = 3; j >= 0; j--) blob.push_back((m_state[i] >> (j * 8)) & 0xff);
+			for (int j = 7; j >= 0; j--) blob.push_back((m_bitlen >> (j * 8)) & 0xff);
+			blob.push_back((unsigned char)m_datalen);
+			blob.insert(blob.end(), m_data, m_data + m_datalen);
+			return blob;
+		}
+	
+		// Restore a state produced by `exportState`. Returns false (and keeps the current state) if `blob` is malformed
+		// (wrong tag or size, or a bit length that isn't a whole number of blocks).
+		bool importState(const unsigned char* blob, size_t len) {
+			if (len < StateHeaderSize || blob[0] != StateTag) return false;
+			size_t datalen = blob[StateHeaderSize - 1];
+			if (datalen >= BlockSize || len != StateHeaderSize + datalen) return false;
+	
+			const unsigned char* p = blob + 1;
+			uint32_t state[8];
+			for (int i = 0; i < 8; i++) {
+				state[i] = 0;
+				for (int j = 0; j < 4; j++) state[i] = (state[i] << 8) | *p++;
+			}
+			uint64_t bitlen = 0;
+			for (int j = 0; j < 8; j++) bitlen = (bitlen << 8) | *p++;
+			// Only whole blocks are counted mid-stream.
+			if (bitlen % (BlockSize * 8)) return false;
+			m_bitlen = bitlen;
+			memcpy(m_state, state, sizeof m_state);
+			m_datalen = datalen;
+			memcpy(m_data, blob + StateHeaderSize, datalen);
+			return true;
+		}
+	
+		bool importState(const std::vector<unsigned char> &blob) {
+			return importState(blob.data(), blob.size());
+		}
+	
 		// Utility: convert digest to hexadecimal string.
 		static std::string toHexString(const unsigned char* digest) {
 			std::ostringstream oss;
@@ -86,6 +131,10 @@ namespace jdevtools {
 		}
 	
 	private:
+		static constexpr unsigned char StateTag = 0x01;
+		// tag + state + bit length + buffered byte count
+		static constexpr size_t StateHeaderSize = 1 + 8 * 4 + 8 + 1;
+	
 		void init() {
 			m_datalen = 0;
 			m_bitlen = 0;
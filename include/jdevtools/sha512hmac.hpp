@@ -8,6 +8,12 @@
 #include <cstdint>
 #include <vector>
 
+// AVX2/BMI2 transform, picked at runtime (define `JDEVTOOLS_NO_SIMD` to force the portable one)
+#if !defined(JDEVTOOLS_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define JDEVTOOLS_SHA512_AVX2
+#include <immintrin.h>
+#endif
+
 namespace jdevtools {
 	class SHA512 {
 	public:
@@ -18,15 +24,25 @@ namespace jdevtools {
 	
 		// Process input data in chunks.
 		void update(const unsigned char* data, size_t len) {
-			for (size_t i = 0; i < len; i++) {
-				m_data[m_datalen] = data[i];
-				m_datalen++;
-				if (m_datalen == BlockSize) {
-					transform(m_data);
-					addBitLength(BlockSize * 8); // 128 bytes * 8 = 1024 bits
-					m_datalen = 0;
-				}
+			// Top up a partially filled block first.
+			if (m_datalen) {
+				size_t take = len < BlockSize - m_datalen ? len : BlockSize - m_datalen;
+				if (take) memcpy(m_data + m_datalen, data, take);
+				m_datalen += take;
+				data += take;
+				len -= take;
+				if (m_datalen < BlockSize) return;
+				transform(m_data);
+				addBitLength(BlockSize * 8);
+				m_datalen = 0;
 			}
+			// Whole blocks are hashed straight from the input.
+			for (; len >= BlockSize; data += BlockSize, len -= BlockSize) {
+				transform(data);
+				addBitLength(BlockSize * 8); // 128 bytes * 8 = 1024 bits
+			}
+			if (len) memcpy(m_data, data, len);
+			m_datalen = len;
 		}
 	
 		// Finalize the hash and produce the digest.
@@ -82,6 +98,54 @@ namespace jdevtools {
 			return std::vector<unsigned char>(digest, digest + DigestSize);
 		}
 	
+		// Copy of the current state, e.g. to hash many messages sharing a common prefix.
+		SHA512 clone() const { return *this; }
+	
+		// Serialize the intermediate state so hashing can be resumed later (or in another process) with `importState`.
+		// Layout (big-endian): tag 0x02, state, bit length, buffered byte count, buffered bytes (82 + 0..BlockSize - 1 bytes).
+		std::vector<unsigned char> exportState() const {
+			std::vector<unsigned char> blob;
+			blob.reserve(StateHeaderSize + m_datalen);
+			blob.push_back(StateTag);
+			for (int i = 0; i < 8; i++)
+				for (int j = 7; j >= 0; j--) blob.push_back((m_state[i] >> (j * 8)) & 0xff);
+			for (int k = 0; k < 2; k++)
+				for (int j = 7; j >= 0; j--) blob.push_back((m_bitlen[k] >> (j * 8)) & 0xff);
+			blob.push_back((unsigned char)m_datalen);
+			blob.insert(blob.end(), m_data, m_data + m_datalen);
+			return blob;
+		}
+	
+		// Restore a state produced by `exportState`. Returns false (and keeps the current state) if `blob` is malformed
+		// (wrong tag or size, or a bit length that isn't a whole number of blocks).
+		bool importState(const unsigned char* blob, size_t len) {
+			if (len < StateHeaderSize || blob[0] != StateTag) return false;
+			size_t datalen = blob[StateHeaderSize - 1];
+			if (datalen >= BlockSize || len != StateHeaderSize + datalen) return false;
+	
+			const unsigned char* p = blob + 1;
+			uint64_t state[8];
+			for (int i = 0; i < 8; i++) {
+				state[i] = 0;
+				for (int j = 0; j < 8; j++) state[i] = (state[i] << 8) | *p++;
+			}
+			uint64_t bitlen[2] = {0, 0};
+			for (int k = 0; k < 2; k++)
+				for (int j = 0; j < 8; j++) bitlen[k] = (bitlen[k] << 8) | *p++;
+			// Only whole blocks are counted mid-stream.
+			if (bitlen[1] % (BlockSize * 8)) return false;
+			m_bitlen[0] = bitlen[0];
+			m_bitlen[1] = bitlen[1];
+			memcpy(m_state, state, sizeof m_state);
+			m_datalen = datalen;
+			memcpy(m_data, blob + StateHeaderSize, datalen);
+			return true;
+		}
+	
+		bool importState(const std::vector<unsigned char> &blob) {
+			return importState(blob.data(), blob.size());
+		}
+	
 		// Utility: convert digest to hexadecimal string.
 		static std::string toHexString(const unsigned char* digest) {
 			std::ostringstream oss;
@@ -92,6 +156,10 @@ namespace jdevtools {
 		}
 	
 	private:
+		static constexpr unsigned char StateTag = 0x02;
+		// tag + state + bit length + buffered byte count
+		static constexpr size_t StateHeaderSize = 1 + 8 * 8 + 16 + 1;
+	
 		// Initialize SHA512 context.
 		void init() {
 			m_datalen = 0;
@@ -107,8 +175,60 @@ namespace jdevtools {
 			m_state[7] = 0x5be0cd19137e2179ULL;
 		}
 	
+		// Round constants (first 64 bits of the fractional parts of the cube roots of the first 80 primes)
+		static constexpr uint64_t K[80] = {
+			0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL,
+			0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+			0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL,
+			0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+			0xd807aa98a3030242ULL, 0x12835b0145706fbeULL,
+			0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+			0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL,
+			0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+			0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL,
+			0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+			0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL,
+			0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+			0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL,
+			0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+			0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL,
+			0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+			0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL,
+			0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+			0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL,
+			0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+			0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL,
+			0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+			0xd192e819d6ef5218ULL, 0xd69906245565a910ULL,
+			0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+			0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL,
+			0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+			0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL,
+			0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+			0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL,
+			0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+			0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL,
+			0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+			0xca273eceea26619cULL, 0xd186b8c721c0c207ULL,
+			0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+			0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL,
+			0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+			0x28db77f523047d84ULL, 0x32caab7b40c72493ULL,
+			0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+			0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL,
+			0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+		};
+	
 		// SHA512 transformation function. Processes one 1024-bit block.
 		void transform(const unsigned char data[]) {
+		#ifdef JDEVTOOLS_SHA512_AVX2
+			if (hasAvx2Bmi2()) return transformAvx2(data);
+		#endif
+			transformGeneric(data);
+		}
+	
+		// Portable transform.
+		void transformGeneric(const unsigned char data[]) {
 			uint64_t m[80];
 	
 			// Macros for 64-bit operations.
@@ -140,51 +260,9 @@ namespace jdevtools {
 			uint64_t g = m_state[6];
 			uint64_t h = m_state[7];
 	
-			static const uint64_t k[80] = {
-				0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL,
-				0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
-				0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL,
-				0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
-				0xd807aa98a3030242ULL, 0x12835b0145706fbeULL,
-				0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
-				0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL,
-				0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
-				0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL,
-				0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
-				0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL,
-				0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
-				0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL,
-				0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
-				0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL,
-				0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
-				0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL,
-				0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
-				0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL,
-				0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
-				0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL,
-				0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
-				0xd192e819d6ef5218ULL, 0xd69906245565a910ULL,
-				0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
-				0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL,
-				0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
-				0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL,
-				0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
-				0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL,
-				0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
-				0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL,
-				0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
-				0xca273eceea26619cULL, 0xd186b8c721c0c207ULL,
-				0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
-				0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL,
-				0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
-				0x28db77f523047d84ULL, 0x32caab7b40c72493ULL,
-				0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
-				0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL,
-				0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
-			};
 	
 			for (unsigned int i = 0; i < 80; i++) {
-				uint64_t t1 = h + SIGMA1(e) + CH(e, f, g) + k[i] + m[i];
+				uint64_t t1 = h + SIGMA1(e) + CH(e, f, g) + K[i] + m[i];
 				uint64_t t2 = SIGMA0(a) + MAJ(a, b, c);
 				h = g;
 				g = f;
@@ -214,6 +292,108 @@ namespace jdevtools {
 			#undef sigma1
 		}
 	
+	#ifdef JDEVTOOLS_SHA512_AVX2
+		// Checked once per process.
+		static bool hasAvx2Bmi2() {
+			static const bool supported = (__builtin_cpu_init(),
+				__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2"));
+			return supported;
+		}
+	
+		// AVX2 transform: message schedule 4 words at a time, rounds unrolled 8 at a time with rotating
+		// variable names (no register shuffling), rotates compile to BMI2 `rorx`.
+		__attribute__((target("avx2,bmi2")))
+		void transformAvx2(const unsigned char data[]) {
+			alignas(32) uint64_t m[80];
+	
+			#define ROTR64(x,n) (((x) >> (n)) | ((x) << (64 - (n))))
+			#define CH(x,y,z) ((z) ^ ((x) & ((y) ^ (z))))
+			#define MAJ(x,y,z) (((x) & (y)) | ((z) & ((x) | (y))))
+			#define SIGMA0(x) (ROTR64((x),28) ^ ROTR64((x),34) ^ ROTR64((x),39))
+			#define SIGMA1(x) (ROTR64((x),14) ^ ROTR64((x),18) ^ ROTR64((x),41))
+			#define VROTR64(x,n) _mm256_or_si256(_mm256_srli_epi64((x),(n)), _mm256_slli_epi64((x),64 - (n)))
+			#define vsigma0(x) _mm256_xor_si256(_mm256_xor_si256(VROTR64((x),1), VROTR64((x),8)), _mm256_srli_epi64((x),7))
+			#define XROTR64(x,n) _mm_or_si128(_mm_srli_epi64((x),(n)), _mm_slli_epi64((x),64 - (n)))
+			#define xsigma1(x) _mm_xor_si128(_mm_xor_si128(XROTR64((x),19), XROTR64((x),61)), _mm_srli_epi64((x),6))
+	
+			// Load the block as big-endian words.
+			const __m256i bswap = _mm256_setr_epi8(
+				7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+				7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+			for (int i = 0; i < 16; i += 4) {
+				__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i * 8));
+				_mm256_store_si256(reinterpret_cast<__m256i*>(m + i), _mm256_shuffle_epi8(v, bswap));
+			}
+	
+			// m[i..i+3] = sigma1(m[i-2..i+1]) + m[i-7..i-4] + sigma0(m[i-15..i-12]) + m[i-16..i-13].
+			// sigma1 of the upper pair depends on the lower pair, so that term is added in two halves.
+			for (int i = 16; i < 80; i += 4) {
+				__m256i t = _mm256_add_epi64(
+					_mm256_add_epi64(_mm256_load_si256(reinterpret_cast<const __m256i*>(m + i - 16)),
+						vsigma0(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(m + i - 15)))),
+					_mm256_loadu_si256(reinterpret_cast<const __m256i*>(m + i - 7)));
+				__m128i lo = _mm_add_epi64(_mm256_castsi256_si128(t),
+					xsigma1(_mm_load_si128(reinterpret_cast<const __m128i*>(m + i - 2))));
+				__m128i hi = _mm_add_epi64(_mm256_extracti128_si256(t, 1), xsigma1(lo));
+				_mm_store_si128(reinterpret_cast<__m128i*>(m + i), lo);
+				_mm_store_si128(reinterpret_cast<__m128i*>(m + i + 2), hi);
+			}
+	
+			// Pre-add the round constants.
+			for (int i = 0; i < 80; i += 4) {
+				__m256i w = _mm256_load_si256(reinterpret_cast<const __m256i*>(m + i));
+				__m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(K + i));
+				_mm256_store_si256(reinterpret_cast<__m256i*>(m + i), _mm256_add_epi64(w, k));
+			}
+	
+			uint64_t a = m_state[0];
+			uint64_t b = m_state[1];
+			uint64_t c = m_state[2];
+			uint64_t d = m_state[3];
+			uint64_t e = m_state[4];
+			uint64_t f = m_state[5];
+			uint64_t g = m_state[6];
+			uint64_t h = m_state[7];
+	
+			// One round: `h` becomes the new `a`, `d` the new `e`; callers rotate the names instead.
+			#define ROUND(a,b,c,d,e,f,g,h,i) \
+				h += SIGMA1(e) + CH(e, f, g) + m[i]; \
+				d += h; \
+				h += SIGMA0(a) + MAJ(a, b, c);
+	
+			for (int i = 0; i < 80; i += 8) {
+				ROUND(a, b, c, d, e, f, g, h, i);
+				ROUND(h, a, b, c, d, e, f, g, i + 1);
+				ROUND(g, h, a, b, c, d, e, f, i + 2);
+				ROUND(f, g, h, a, b, c, d, e, i + 3);
+				ROUND(e, f, g, h, a, b, c, d, i + 4);
+				ROUND(d, e, f, g, h, a, b, c, i + 5);
+				ROUND(c, d, e, f, g, h, a, b, i + 6);
+				ROUND(b, c, d, e, f, g, h, a, i + 7);
+			}
+	
+			m_state[0] += a;
+			m_state[1] += b;
+			m_state[2] += c;
+			m_state[3] += d;
+			m_state[4] += e;
+			m_state[5] += f;
+			m_state[6] += g;
+			m_state[7] += h;
+	
+			#undef ROUND
+			#undef ROTR64
+			#undef CH
+			#undef MAJ
+			#undef SIGMA0
+			#undef SIGMA1
+			#undef VROTR64
+			#undef vsigma0
+			#undef XROTR64
+			#undef xsigma1
+		}
+	#endif
+	
 		// Helper to update the 128-bit length (stored as two 64-bit words).
 		void addBitLength(uint64_t bits) {
 			m_bitlen[1] += bits;